@@ -55,6 +55,16 @@ struct ConnectBoard {
         return ConnectBoard{pieces | (pieces + (1ull << 8ull * col)), player ^ pieces, };
     }
 
+    [[nodiscard]] inline int move_count() const noexcept {
+        // Counts set bits besides the turn counter bit, which is always set in pieces
+        int count{};
+        for (board rest = pieces ^ (1ull << 63ull); rest; ++count) {
+            rest &= rest - 1;
+        }
+
+        return count;
+    }
+
     [[nodiscard]] inline bool game_over(const int chain) const noexcept {
         return (chain == 3 && connect_three_game_over()) || (chain == 4 && connect_four_game_over());
     }
@@ -139,6 +149,23 @@ private:
     }
 };
 
+// Center columns take part in the most chains, so searches try them first
+struct MoveOrder {
+    explicit MoveOrder(int cols) {
+        // A board holds at most 8 columns, one per byte
+        for (int i = 0; i < cols && i < 8; ++i) {
+            columns[i] = cols / 2 + (1 - 2 * (i % 2)) * (i + 1) / 2;
+        }
+    }
+
+    inline unsigned char operator[] (int i) const noexcept {
+        return columns[i];
+    }
+
+private:
+    unsigned char columns[8]{};
+};
+
 template <>
 struct std::hash<ConnectBoard> {
     std::size_t operator() (const ConnectBoard game) const {
@@ -1,6 +1,10 @@
 #ifndef CONNECTFOUR_MINIMAX_HPP
 #define CONNECTFOUR_MINIMAX_HPP
 
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
 #include <functional>
 #include <unordered_map>
 
@@ -10,23 +14,47 @@
 /* FullMiniMax implements a full search of the game tree. Heuristic MiniMax uses all available tricks to search the game tree efficiently.
  * Side note: The two classes are not good candidates for inheritance due to significant virtual method overhead for the 100,000's to 1,000,000's of time those functions are called. */
 
+// Score and principal variation of a single root move, an inexact score is only an upper bound
+struct Variation {
+    unsigned char column;
+    int score;
+    bool exact;
+    std::vector<unsigned char> moves;
+};
+
+// Appends the move next_move picks for each state (-1 for none) until the game ends or no move is known
+template <typename NextMove>
+void principal_variation(ConnectBoard board, int rows, int cols, int chain, NextMove next_move, std::vector<unsigned char>& moves) {
+    while (moves.size() < static_cast<std::size_t>(rows * cols) && !board.game_over(chain) && !board.is_full(cols, rows)) {
+        int move = next_move(board);
+
+        if (move < 0 || board.is_invalid_move(move, rows))
+            break;
+
+        moves.push_back(move);
+        board = board.make_neighbor(move);
+    }
+}
+
 struct FullMiniMax {
-    FullMiniMax(int rows, int cols, int chain, bool optimized=true, bool verbose=true): rows(rows), cols(cols), chain(chain), verbose(verbose),
-    optimized(optimized) {}
+    FullMiniMax(int rows, int cols, int chain, bool optimized=true, bool verbose=true, bool weak=false): rows(rows), cols(cols), chain(chain),
+    verbose(verbose), optimized(optimized), weak(weak), move_order(cols) {}
 
     auto operator() (ConnectBoard board) {
         if (table.find(board) == table.end()) {
             Stopwatch timer;
 
-            if (optimized) {
-                efficient_traverse(board, true);
+            if (weak) {
+                weak_solve(board);
+            } else if (optimized) {
+                efficient_traverse(board, board.move_count());
             } else {
-                traverse(board, true);
+                traverse(board, board.move_count());
             }
 
             if (verbose) {
                 std::cout << "MiniMax search completed in " << timer << ".\n";
-                std::cout << table.size() << " states in the table." << std::endl;
+                std::cout << (weak? weak_table.size() : table.size()) << " states in the table." << std::endl;
             }
         }
 
@@ -36,9 +64,9 @@ struct FullMiniMax {
             std::cout << "This state has a value of " << score << ".\n";
 
             if (score > 0)
-                std::cout << "First player will win with optimal play.";
-            else if (score > 0)
-                std::cout << "Second player will win with optimal play.";
+                std::cout << "The player to move will win with optimal play.";
+            else if (score < 0)
+                std::cout << "The player to move will lose with optimal play.";
             else
                 std::cout << "The players will tie with optimal play.";
 
@@ -48,8 +76,76 @@ struct FullMiniMax {
         return table[board];
     }
 
+    std::vector<Variation> analyze(ConnectBoard board) {
+        // Scores every root move with one shared table, so later moves reuse the states explored for earlier ones
+
+        Stopwatch timer;
+        std::vector<Variation> lines;
+        const int depth = board.move_count();
+
+        // Weak solves only put their roots in table, the states below them are in weak_table
+        auto next_move = [this](const ConnectBoard state) {
+            if (auto entry = table.find(state); entry != table.end())
+                return static_cast<int>(entry->second.second);
+
+            if (auto bounds = weak_table.find(state); bounds != weak_table.end())
+                return static_cast<int>(bounds->second.move);
+
+            // Immediate wins are returned before they are stored, so finish the line on the winning column
+            for (int col = 0; col < cols; ++col) {
+                if (!state.is_invalid_move(col, rows) && state.make_neighbor(col).game_over(chain))
+                    return col;
+            }
+
+            return -1;
+        };
+
+        for (int col = 0; col < cols; ++col) {
+            if (board.is_invalid_move(col, rows))
+                continue;
+
+            auto next = board.make_neighbor(col);
+            Variation line{static_cast<unsigned char>(col), 0, true, {static_cast<unsigned char>(col)}};
+
+            // traverse scores a finished game one ply deeper, so only the other searches take the shortcut
+            if ((optimized || weak) && next.game_over(chain))
+                line.score = weak? 1 : score(depth + 1);
+            else if (weak)
+                line.score = -weak_solve(next);
+            else if (optimized)
+                line.score = -efficient_traverse(next, depth + 1);
+            else
+                line.score = -traverse(next, depth + 1);
+
+            principal_variation(next, rows, cols, chain, next_move, line.moves);
+            lines.push_back(line);
+        }
+
+        std::stable_sort(lines.begin(), lines.end(), [](const Variation& a, const Variation& b) {
+            return a.score > b.score;
+        });
+
+        // The best root move is known now too
+        if (!lines.empty())
+            table[board] = std::make_pair(lines.front().score, lines.front().column);
+
+        if (verbose) {
+            std::cout << "MiniMax analysis completed in " << timer << ".\n";
+
+            for (auto& line : lines)
+                std::cout << "Column " << static_cast<int>(line.column) << " has a value of " << line.score << ".\n";
+
+            std::cout << std::endl;
+        }
+
+        return lines;
+    }
+
 private:
-    int efficient_traverse(const ConnectBoard board, bool max, int depth=0) {
+    /* Both traversals score states for the player to move (negamax) and depth is the number of pieces on the board,
+     * so a memoized score does not depend on which root first reached the state. */
+
+    int efficient_traverse(const ConnectBoard board, int depth) {
         // MiniMax traversal with transposition table
 
         // Memoized states needn't be explored again
@@ -60,20 +156,10 @@ private:
         if (depth == rows * cols)
             return 0;
 
-        // Keep generic for min/max in same loop
-        int best_score;
+        int best_score{std::numeric_limits<int>::min()};
         unsigned char best_move;
-        std::function<bool(int, int)> compare;
 
-        if (max) {
-            best_score = std::numeric_limits<int>::min();
-            compare = std::greater<>();
-        } else {
-            best_score = std::numeric_limits<int>::max();
-            compare = std::less<>();
-        }
-
-        // Examine all neighboring boards and take min/max
+        // Examine all neighboring boards and take the best for the player to move
         int current;
         for (int col = 0; col < cols; ++col) {
             if (board.is_invalid_move(col, rows))
@@ -81,18 +167,16 @@ private:
 
             auto next = board.make_neighbor(col);
 
-            /* We always take the move we can win
-             * Initially, I thought this could cause a problem with a min player not choosing
-             * a win move if possible, but min player simply cannot win in our implementation */
+            // We always take the move we can win
             if (next.game_over(chain)) {
                 best_move = col;
-                best_score = max? score(depth + 1) : -score(depth + 1);
+                best_score = score(depth + 1);
                 break;
             }
 
-            current = efficient_traverse(board.make_neighbor(col), not max, depth + 1);
+            current = -efficient_traverse(next, depth + 1);
 
-            if (compare(current, best_score)) {
+            if (current > best_score) {
                 best_score = current;
                 best_move = col;
             }
@@ -102,15 +186,16 @@ private:
         return best_score;
     }
 
-    int traverse(const ConnectBoard board, bool max, int depth=0) {
+    int traverse(const ConnectBoard board, int depth) {
         // MiniMax traversal with transposition table
 
         // Memoized states needn't be explored again
         if (table.find(board) != table.end())
             return table[board].first;
 
+        // The previous player won
         if (board.game_over(chain)) {
-            int best_score = max? -score(depth + 1) : score(depth + 1);
+            int best_score = -score(depth + 1);
             table[board] = std::make_pair(best_score, 0);
             return best_score;
         }
@@ -121,28 +206,18 @@ private:
             return 0;
         }
 
-        // Keep generic for min/max in same loop
-        int best_score;
+        int best_score{std::numeric_limits<int>::min()};
         unsigned char best_move;
-        std::function<bool(int, int)> compare;
 
-        if (max) {
-            best_score = std::numeric_limits<int>::min();
-            compare = std::greater<>();
-        } else {
-            best_score = std::numeric_limits<int>::max();
-            compare = std::less<>();
-        }
-
-        // Examine all neighboring boards and take min/max
+        // Examine all neighboring boards and take the best for the player to move
         int current;
         for (int col = 0; col < cols; ++col) {
             if (board.is_invalid_move(col, rows))
                 continue;
 
-            current = traverse(board.make_neighbor(col), not max, depth + 1);
+            current = -traverse(board.make_neighbor(col), depth + 1);
 
-            if (compare(current, best_score)) {
+            if (current > best_score) {
                 best_score = current;
                 best_move = col;
             }
@@ -152,13 +227,114 @@ private:
         return best_score;
     }
 
+    int weak_solve(const ConnectBoard board) {
+        /* Only decides win (1), draw (0), or loss (-1) for the player to move using two null window searches.
+         * The first search stops as soon as a winning move is found, the second separates draws from losses. */
+
+        for (int col = 0; col < cols; ++col) {
+            if (!board.is_invalid_move(col, rows) && board.make_neighbor(col).game_over(chain)) {
+                table[board] = std::make_pair(1, col);
+                return 1;
+            }
+        }
+
+        int best_score = weak_traverse(board, 0, 1);
+
+        if (best_score < 1)
+            best_score = weak_traverse(board, -1, 0);
+
+        table[board] = std::make_pair(best_score, weak_table[board].move);
+        return best_score;
+    }
+
+    int weak_traverse(const ConnectBoard board, int alpha, int beta) {
+        // Negamax traversal with αβ pruning on win/draw/loss values and a transposition table of bounds
+
+        // We always take the move we can win
+        for (int col = 0; col < cols; ++col) {
+            if (!board.is_invalid_move(col, rows) && board.make_neighbor(col).game_over(chain))
+                return 1;
+        }
+
+        // Memoized bounds either settle the state or narrow the window
+        Bounds bounds{-1, 1, 0};
+        auto entry = weak_table.find(board);
+        const bool known = entry != weak_table.end();
+        if (known) {
+            bounds = entry->second;
+
+            if (bounds.lower >= beta)
+                return bounds.lower;
+
+            if (bounds.upper <= alpha)
+                return bounds.upper;
+
+            alpha = std::max<int>(alpha, bounds.lower);
+            beta = std::min<int>(beta, bounds.upper);
+        }
+
+        const int initial_alpha = alpha;
+
+        int current, best_score{-2};
+        bool moved{false};
+        for (int i = 0; i < cols; ++i) {
+            int col = move_order[i];
+
+            if (board.is_invalid_move(col, rows))
+                continue;
+
+            // Any legal move will do when every move loses
+            if (!moved && !known)
+                bounds.move = col;
+
+            moved = true;
+            current = -weak_traverse(board.make_neighbor(col), -beta, -alpha);
+
+            if (current > best_score) {
+                best_score = current;
+
+                if (best_score > initial_alpha)
+                    bounds.move = col;
+
+                if (best_score > alpha)
+                    alpha = best_score;
+
+                // Best score is outside our αβ bound -> quit
+                if (alpha >= beta)
+                    break;
+            }
+        }
+
+        // Filled the whole board without a win
+        if (!moved)
+            return 0;
+
+        // Fail low only gives an upper bound, fail high only a lower bound
+        if (best_score < beta)
+            bounds.upper = static_cast<signed char>(best_score);
+
+        if (best_score > initial_alpha)
+            bounds.lower = static_cast<signed char>(best_score);
+
+        weak_table[board] = bounds;
+        return best_score;
+    }
+
     [[nodiscard]] inline int score(int depth) const noexcept {
         return 10'000 * rows * cols / depth;
     }
 
+    // Weak solve values fit in a byte, so bounds and move take three bytes per state
+    struct Bounds {
+        signed char lower, upper;
+        unsigned char move;
+    };
+
     const int rows, cols, chain;
-    const bool verbose, optimized;
+    const bool verbose, optimized, weak;
+    const MoveOrder move_order;
     std::unordered_map<ConnectBoard, std::pair<int, unsigned char>> table;
+    std::unordered_map<ConnectBoard, Bounds> weak_table;
 };
 
 struct HeuristicMiniMax {
@@ -179,13 +355,73 @@ struct HeuristicMiniMax {
         Stopwatch timer;
         traverse(board, true);
 
+        auto [score, move, lower, upper] = table[board];
+
         if (verbose) {
             std::cout << "MiniMax search completed in " << timer << ".\n";
             std::cout << table.size() << " states in transposition table." << std::endl;
-            std::cout << "This state has a score of " << table[board].first << ".\n\n";
+            std::cout << "This state has a score of " << score << ".\n\n";
         }
 
-        return table[board];
+        return std::make_pair(score, move);
+    }
+
+    std::vector<Variation> analyze(ConnectBoard board, int count=0) {
+        /* Scores every root move with one table. Only the best count moves (all when 0) get exact scores,
+         * the rest are searched against the count-th best score so far and only keep an upper bound. */
+        table.clear(); // Remove table entries because of depth
+
+        Stopwatch timer;
+        std::vector<Variation> lines;
+        std::vector<int> exact_scores;
+
+        auto next_move = [this](const ConnectBoard state) {
+            auto entry = table.find(state);
+            return entry == table.end()? -1 : static_cast<int>(entry->second.move);
+        };
+
+        for (int col = 0; col < cols; ++col) {
+            if (board.is_invalid_move(col, rows))
+                continue;
+
+            // Moves scoring below the count-th best cannot enter the top count
+            int alpha = std::numeric_limits<int>::min();
+            if (count > 0 && exact_scores.size() >= static_cast<std::size_t>(count)) {
+                std::nth_element(exact_scores.begin(), exact_scores.begin() + count - 1, exact_scores.end(), std::greater<>());
+                alpha = exact_scores[count - 1];
+            }
+
+            auto child = board.make_neighbor(col);
+            Variation line{static_cast<unsigned char>(col), win_score, true, {static_cast<unsigned char>(col)}};
+
+            if (!child.game_over(chain)) {
+                line.score = traverse(child, false, 2, alpha);
+                line.exact = line.score >= alpha;
+            }
+
+            if (line.exact)
+                exact_scores.push_back(line.score);
+
+            principal_variation(child, rows, cols, chain, next_move, line.moves);
+            lines.push_back(line);
+        }
+
+        std::stable_sort(lines.begin(), lines.end(), [](const Variation& a, const Variation& b) {
+            return a.score > b.score;
+        });
+
+        if (verbose) {
+            std::cout << "MiniMax analysis completed in " << timer << ".\n";
+            std::cout << table.size() << " states in transposition table." << std::endl;
+
+            for (auto& line : lines)
+                std::cout << "Column " << static_cast<int>(line.column) << " has a score of " << (line.exact? "" : "at most ")
+                          << line.score << ".\n";
+
+            std::cout << std::endl;
+        }
+
+        return lines;
     }
 
 private:
@@ -194,12 +430,16 @@ private:
                  int beta = std::numeric_limits<int>::max()) {
         // MiniMax traversal with αβ pruning, transposition tables, and a heuristic function
 
-        // Memoized states needn't be explored again
-        if (table.find(board) != table.end())
-            return table[board].first;
+        // Memoized states needn't be explored again, unless a cutoff left a bound that does not decide this window
+        if (auto entry = table.find(board); entry != table.end()) {
+            auto [score, move, lower, upper] = entry->second;
+
+            if ((lower && upper) || (lower && score > beta) || (upper && score < alpha))
+                return score;
+        }
 
         // Evaluate board by counting usable chained pieces of length 1/2/3
-        if (depth == max_depth)
+        if (depth >= max_depth)
             return max? heuristic(board): -heuristic(board);
 
         // Keep generic for min/max in same loop
@@ -219,6 +459,8 @@ private:
             best_score = std::numeric_limits<int>::max();
         }
 
+        const int initial_alpha = alpha, initial_beta = beta;
+
         // Iterate through valid children
         /* If we've made it to this point, nobody has won. If there are no valid moves,
            we have a tied board. */
@@ -258,7 +500,8 @@ private:
         if (!moved)
             return 0;
 
-        table[board] = std::make_pair(best_score, best_move);
+        // Scores below α only bound the true score from above, scores above β from below
+        table[board] = Entry{best_score, best_move, best_score >= initial_alpha, best_score <= initial_beta};
         return best_score;
     }
 
@@ -413,10 +656,17 @@ private:
         return c;
     }
 
+    // The score is a lower bound, an upper bound, or exact when both
+    struct Entry {
+        int score{};
+        unsigned char move{};
+        bool lower{}, upper{};
+    };
+
     const bool verbose;
     unsigned long long boundary_spaces;
     const int max_depth, chain, cols, rows;
-    std::unordered_map<ConnectBoard, std::pair<int, unsigned char>> table;
+    std::unordered_map<ConnectBoard, Entry> table;
     const int win_score=100'000, singleton_value=500, two_chain_value=2'000, three_chain_value=5'000;
 };
 
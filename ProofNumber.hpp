@@ -0,0 +1,261 @@
+#ifndef CONNECTFOUR_PROOFNUMBER_HPP
+#define CONNECTFOUR_PROOFNUMBER_HPP
+
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include "timer.hpp"
+#include "ConnectBoard.hpp"
+
+/* ProofNumberSearch solves positions with depth-first proof-number search (df-pn). Instead of visiting every child like
+ * MiniMax, it always expands the child that needs the fewest wins proven (or refuted), so it follows the least resistant
+ * proof. Draws are neither proofs nor disproofs, so a win/draw/loss result takes two searches: one trying to prove the
+ * player to move wins, then one trying to prove the opponent wins.
+ * The transposition table has a fixed number of slots and overwrites on collision, so memory use is bounded. By default
+ * it grows with the board up to 2^22 slots (128 MiB). */
+
+struct ProofNumberSearch {
+    static constexpr int unknown = std::numeric_limits<int>::min(); // Score when a limit ran out before a proof
+
+    // A table_bits of 0 sizes the table from the board
+    ProofNumberSearch(int rows, int cols, int chain, unsigned long long node_limit=0, double time_limit=0,
+                      int table_bits=0, bool verbose=true): rows(rows), cols(cols), chain(chain),
+                      node_limit(node_limit), time_limit(time_limit), verbose(verbose),
+                      table_shift(64 - (table_bits? table_bits : std::clamp(rows * cols - 4, 10, 22))),
+                      move_order(cols), table(1ull << (64 - table_shift)) {}
+
+    auto operator() (ConnectBoard board) {
+        Stopwatch timer;
+        nodes = 0;
+        aborted = false;
+        watch = &timer;
+
+        int score;
+        unsigned char column;
+
+        // Try to prove the player to move wins
+        Entry win = solve(board, true);
+        column = win.move;
+
+        if (win.phi == 0) {
+            score = 1;
+        } else if (win.delta != 0) {
+            score = unknown;
+        } else {
+            // Not a win, so try to prove the opponent wins, otherwise it is a draw
+            Entry draw = solve(board, false);
+            column = draw.move;
+
+            if (draw.phi == 0)
+                score = 0;
+            else if (draw.delta == 0)
+                score = -1;
+            else
+                score = unknown;
+        }
+
+        if (verbose) {
+            std::cout << "Proof-number search completed in " << timer << ".\n";
+            std::cout << nodes << " nodes expanded." << std::endl;
+
+            if (score == 1)
+                std::cout << "The player to move will win with optimal play.";
+            else if (score == -1)
+                std::cout << "The player to move will lose with optimal play.";
+            else if (score == 0)
+                std::cout << "The players will tie with optimal play.";
+            else
+                std::cout << "The search limit was reached before the state was solved.";
+
+            std::cout << "\n\n";
+        }
+
+        return std::make_pair(score, column);
+    }
+
+private:
+    /* Proof and disproof numbers are stored from the point of view of the player to move as φ and δ.
+     * φ is the number of leaves that must be solved for the player to move to reach its goal and δ the number
+     * needed to refute it. The attacker's goal is a win, the defender's goal is a draw or a win. */
+    struct Entry {
+        ConnectBoard key{0, 0};
+        unsigned phi, delta;
+        unsigned char move;
+        unsigned generation{};
+    };
+
+    Entry solve(const ConnectBoard board, bool attacker) {
+        // Entries from a search for the other attacker have different goals, a new generation hides them
+        ++generation;
+
+        // Wins and losses proven by earlier searches still hold
+        if (Entry root = lookup(board); root.phi == 0 || root.delta == 0)
+            return root;
+
+        // A limit can stop the search before the root is expanded, so start it on a legal column
+        for (int i = 0; i < cols; ++i) {
+            if (!board.is_invalid_move(move_order[i], rows)) {
+                store(Entry{board, 1, 1, move_order[i]}, false);
+                break;
+            }
+        }
+
+        mid(board, attacker, infinity - 1, infinity - 1);
+
+        // φ is 0 when the player to move reached its goal and δ is 0 when it cannot
+        return lookup(board);
+    }
+
+    void mid(const ConnectBoard board, bool attacker, unsigned phi_threshold, unsigned delta_threshold) {
+        // Multiple iterative deepening from Nagai's df-pn, only returns once a threshold is exceeded
+
+        // Checked before counting, so a limit of N expands exactly N nodes
+        if ((node_limit && nodes >= node_limit) ||
+            (time_limit > 0 && (nodes & 4095) == 4095 && watch->measure().count() / 1E9 >= time_limit)) {
+            aborted = true;
+            return;
+        }
+
+        ++nodes;
+
+        Entry entry = lookup(board);
+        entry.key = board;
+
+        // We always take the move we can win, which meets either player's goal
+        bool moved{false};
+        for (int col = 0; col < cols; ++col) {
+            if (board.is_invalid_move(col, rows))
+                continue;
+
+            moved = true;
+
+            if (board.make_neighbor(col).game_over(chain)) {
+                store(Entry{board, 0, infinity, static_cast<unsigned char>(col)}, true);
+                return;
+            }
+        }
+
+        // Filled the whole board without a win, only the defender is happy with a draw
+        if (!moved) {
+            store(attacker? Entry{board, infinity, 0, 0} : Entry{board, 0, infinity, 0}, false);
+            return;
+        }
+
+        // Columns the opponent would win in must be blocked, and two of them cannot both be blocked
+        const ConnectBoard passed{board.pieces, board.player ^ board.pieces};
+        int forced{-1};
+        for (int col = 0; col < cols; ++col) {
+            if (board.is_invalid_move(col, rows) || !passed.make_neighbor(col).game_over(chain))
+                continue;
+
+            if (forced != -1) {
+                store(Entry{board, infinity, 0, static_cast<unsigned char>(col)}, true);
+                return;
+            }
+
+            forced = col;
+        }
+
+        while (true) {
+            // φ is the smallest child δ, δ is the sum of child φ's
+            unsigned phi{infinity}, delta{0}, second_delta{infinity};
+            unsigned char best_move{0};
+            bool first{true};
+
+            for (int i = 0; i < cols; ++i) {
+                int col = move_order[i];
+
+                if (board.is_invalid_move(col, rows) || (forced != -1 && col != forced))
+                    continue;
+
+                const Entry child = lookup(board.make_neighbor(col));
+
+                // Keep a legal column even if every child is refuted
+                if (first || child.delta < phi) {
+                    first = false;
+                    second_delta = phi;
+                    phi = child.delta;
+                    best_move = col;
+                } else if (child.delta < second_delta) {
+                    second_delta = child.delta;
+                }
+
+                delta = saturating_add(delta, child.phi);
+            }
+
+            entry.phi = phi;
+            entry.delta = delta;
+            entry.move = best_move;
+
+            if (phi >= phi_threshold || delta >= delta_threshold || aborted) {
+                // A proof for the attacker or a disproof for the defender is a win or a loss, not a draw
+                store(entry, attacker? phi == 0 : delta == 0);
+                return;
+            }
+
+            /* Give the most proving child as much room as possible before the runner up becomes better.
+             * Letting it run a quarter past the runner up (the 1+ε trick) stops the search from switching back and
+             * forth between close children and re-expanding entries that were overwritten in the meantime. */
+            const auto child = board.make_neighbor(best_move);
+            const Entry current = lookup(child);
+
+            unsigned child_phi_threshold = saturating_add(delta_threshold - delta, current.phi);
+            unsigned child_delta_threshold = std::min(phi_threshold, saturating_add(second_delta, second_delta / 4 + 1));
+
+            mid(child, not attacker, child_phi_threshold, child_delta_threshold);
+        }
+    }
+
+    [[nodiscard]] inline std::size_t index(const ConnectBoard board) const noexcept {
+        /* std::hash<ConnectBoard> folds both boards into the opponent's pieces, so mix them separately.
+         * Fibonacci hashing then spreads boards that only differ in a few low bits across the table. */
+        return ((board.pieces + board.player * 0xC2B2AE3D27D4EB4Full) * 0x9E3779B97F4A7C15ull) >> table_shift;
+    }
+
+    [[nodiscard]] inline Entry lookup(const ConnectBoard board) const noexcept {
+        const Entry& entry = table[index(board)];
+
+        if (entry.key == board && (entry.generation == generation || entry.generation == decisive))
+            return entry;
+
+        // Unseen states start with one leaf to prove, refuting them takes a leaf per legal move
+        unsigned moves{};
+        for (int col = 0; col < cols; ++col) {
+            moves += !board.is_invalid_move(col, rows);
+        }
+
+        return Entry{board, 1, std::max(moves, 1u), 0, generation};
+    }
+
+    inline void store(Entry entry, bool won_or_lost) noexcept {
+        // Wins and losses do not depend on who the attacker is, so they stay valid for every search
+        entry.generation = won_or_lost? decisive : generation;
+        table[index(entry.key)] = entry;
+    }
+
+    static inline unsigned saturating_add(unsigned a, unsigned b) noexcept {
+        if (a >= infinity || b >= infinity)
+            return infinity;
+
+        return std::min<unsigned long long>(static_cast<unsigned long long>(a) + b, infinity - 1);
+    }
+
+    static constexpr unsigned infinity = std::numeric_limits<unsigned>::max();
+    static constexpr unsigned decisive = 0; // Generation of entries that are valid in every search
+
+    const int rows, cols, chain;
+    const unsigned long long node_limit;
+    const double time_limit;
+    const bool verbose;
+    const std::size_t table_shift;
+    const MoveOrder move_order;
+    std::vector<Entry> table;
+
+    unsigned generation{};
+    unsigned long long nodes{};
+    bool aborted{false};
+    const Stopwatch* watch{nullptr};
+};
+
+#endif
@@ -2,6 +2,7 @@
 #include <functional>
 
 #include "MiniMax.hpp"
+#include "ProofNumber.hpp"
 #include "ConnectBoard.hpp"
 
 template <typename MiniMax>
@@ -56,10 +57,13 @@ int main() {
                  "board sizes ranging from 3 to 7 in either dimension.\n";
 
     std::cout << "Part B uses MiniMax with αβ pruning, transposition tables, and a heuristic function to estimate "
-                 "solutions to Connect Three or Four.\n\n";
+                 "solutions to Connect Three or Four.\n";
 
-    while (choice != 'a' && choice != 'b') {
-        std::cout << "Which part would you like to play? Enter A or B: ";
+    std::cout << "Part C uses depth-first proof-number search to prove wins, draws, and losses in positions too deep for "
+                 "MiniMax.\n\n";
+
+    while (choice != 'a' && choice != 'b' && choice != 'c') {
+        std::cout << "Which part would you like to play? Enter A, B, or C: ";
         std::cin >> choice;
 
         choice = static_cast<char>(std::tolower(choice));
@@ -92,11 +96,18 @@ int main() {
             std::transform(optimized.begin(), optimized.end(), optimized.begin(), ::tolower);
         }
 
+        std::string weak{"x"};
+        while (weak != "no" && weak != "yes") {
+            std::cout << "Would you like a weak solve that only decides win, draw, or loss? (yes or no) ";
+            std::cin >> weak;
+            std::transform(weak.begin(), weak.end(), weak.begin(), ::tolower);
+        }
+
 
 
-        FullMiniMax game{rows, cols, chain, optimized == "yes"};
+        FullMiniMax game{rows, cols, chain, optimized == "yes", true, weak == "yes"};
         play_game(game, rows, cols, chain);
-    } else {
+    } else if (choice == 'b') {
         int depth{};
         while (depth < 1) {
             std::cout << "Maximum depth must be a positive integer. Enter maximum depth: ";
@@ -105,5 +116,27 @@ int main() {
 
         HeuristicMiniMax game{rows, cols, chain, depth};
         play_game(game, rows, cols, chain);
+    } else {
+        long long nodes{-1};
+        while (nodes < 0) {
+            std::cout << "Node limit must be a non-negative integer, 0 for no limit. Enter node limit: ";
+            std::cin >> nodes;
+        }
+
+        double seconds{-1};
+        while (seconds < 0) {
+            std::cout << "Time limit must be non-negative, 0 for no limit. Enter time limit in seconds: ";
+            std::cin >> seconds;
+        }
+
+        int bits{-1};
+        while (bits < 0 || bits > 26) {
+            std::cout << "Table size must be in [1, 26] bits, each bit doubles the memory used (26 bits is 2 GiB), "
+                         "0 to size it from the board. Enter table size in bits: ";
+            std::cin >> bits;
+        }
+
+        ProofNumberSearch game{rows, cols, chain, static_cast<unsigned long long>(nodes), seconds, bits};
+        play_game(game, rows, cols, chain);
     }
 }